@@ -26,4 +26,20 @@ struct RGB_t {
   uint8_t blue{};
 };
 
+enum class LedEffect : uint8_t {
+  Solid = 0,
+};
+
+// State published by the LedService after every frame and power change
+struct LedState {
+  RGB_t color{};
+  bool powerOn{};
+  uint8_t brightness{};
+  LedEffect effect{};
+  uint16_t frameRateX10{}; // frames per second times 10
+  uint32_t frameCount{};
+  uint32_t lastFrameMs{}; // esp_timer time of the last frame
+  uint32_t logDrops{};
+};
+
 #endif // BC_APPLICATION_TYPES_H
\ No newline at end of file
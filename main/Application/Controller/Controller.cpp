@@ -16,6 +16,7 @@
 
 #include "Controller.h"
 #include "Application/ApplicationTypes.h"
+#include "Application/Logging/DeferredLogger.h"
 
 #include <esp_log.h>
 #include <freertos/idf_additions.h>
@@ -30,5 +31,6 @@ Controller::Controller(){};
 
 void Controller::Start() {
   ESP_LOGI(LOG_TAG, "Start Application");
+  DeferredLogger::Start();
   m_ledService.Start();
 }
@@ -20,6 +20,8 @@
 #include "Application/ApplicationTypes.h"
 
 #include <cstdint>
+#include <freertos/FreeRTOS.h>
+#include <freertos/timers.h>
 #include <functional>
 #include <host/ble_gatt.h>
 #include <host/ble_uuid.h>
@@ -32,11 +34,13 @@ class NimBleDriver {
 public:
   using NewRGBValueCallback = std::function<void(RGB_t newRGBValue)>;
   using NewLedPowerModeCallback = std::function<void(bool powerOn)>;
+  using ReadStateCallback = std::function<LedState()>;
   explicit NimBleDriver(
       const NewRGBValueCallback &NewRGBValueCallbackFunc,
-      const NewLedPowerModeCallback &NewLedPowerModeCallbackfunc);
+      const NewLedPowerModeCallback &NewLedPowerModeCallbackfunc,
+      const ReadStateCallback &ReadStateCallbackFunc);
 
-  void Init() const;
+  void Init();
 
 private:
   void GattSvrInit() const;
@@ -49,12 +53,18 @@ private:
                            struct ble_gatt_access_ctxt *ctxt, void *arg);
   static int GattAccessLedOnOff(uint16_t conn_handle, uint16_t attr_handle,
                                 struct ble_gatt_access_ctxt *ctxt, void *arg);
+  static int GattAccessState(uint16_t conn_handle, uint16_t attr_handle,
+                             struct ble_gatt_access_ctxt *ctxt, void *arg);
+  static void NotifyStateTimer(TimerHandle_t timer);
   static int GattSvrChrWrite(struct os_mbuf *data, uint16_t min_len,
                              uint16_t max_len, char *dst, uint16_t *len);
 
 private:
   NewRGBValueCallback m_newRGBValueCallback;
   NewLedPowerModeCallback m_newLedPowerModeCallback;
+  ReadStateCallback m_readStateCallback;
+
+  static inline uint16_t m_stateValHandle{};
 
   constexpr static const ble_uuid128_t gattUuidSvr =
       BLE_UUID128_INIT(0x04, 0x00, 0x34, 0xbc, 0x64, 0x04, 0x9a, 0xda, 0xcf,
@@ -68,14 +78,18 @@ private:
       BLE_UUID128_INIT(0x03, 0x00, 0x21, 0xab, 0x53, 0x03, 0x89, 0xc9, 0xde,
                        0x22, 0xed, 0x57, 0x87, 0xad, 0xbf, 0xd1);
   // d1bfad87-57ed-22de-c989-0353ab210003
+  constexpr static const ble_uuid128_t gattUuidState =
+      BLE_UUID128_INIT(0x06, 0x00, 0x56, 0xde, 0x86, 0x06, 0xbc, 0xfc, 0xc0,
+                       0x55, 0xf0, 0x8a, 0xba, 0xd0, 0xe0, 0xa4);
+  // a4e0d0ba-8af0-55c0-fcbc-0686de560006
 
-  const ble_gatt_chr_def m_gattCharacteristics[3] = {
+  const ble_gatt_chr_def m_gattCharacteristics[4] = {
       {
           .uuid = &gattUuidRGB.u,
           .access_cb = GattAccessRGB,
           .arg = this,
           .descriptors = nullptr,
-          .flags = BLE_GATT_CHR_F_WRITE, // | BLE_GATT_CHR_F_READ
+          .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ,
           .min_key_size = 0,
           .val_handle = nullptr,
           .cpfd = nullptr,
@@ -85,11 +99,21 @@ private:
           .access_cb = GattAccessLedOnOff,
           .arg = this,
           .descriptors = nullptr,
-          .flags = BLE_GATT_CHR_F_WRITE, // | BLE_GATT_CHR_F_READ
+          .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ,
           .min_key_size = 0,
           .val_handle = nullptr,
           .cpfd = nullptr,
       },
+      {
+          .uuid = &gattUuidState.u,
+          .access_cb = GattAccessState,
+          .arg = this,
+          .descriptors = nullptr,
+          .flags = BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
+          .min_key_size = 0,
+          .val_handle = &m_stateValHandle,
+          .cpfd = nullptr,
+      },
       {
           // NOTE: no more characteristics
       }};
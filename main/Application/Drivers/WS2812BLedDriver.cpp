@@ -16,6 +16,7 @@
 
 #include "WS2812BLedDriver.h"
 #include "Application/ApplicationTypes.h"
+#include "Application/Logging/DeferredLogger.h"
 
 #include <array>
 #include <cstdint>
@@ -39,12 +40,11 @@ WS2812BLedDriver::WS2812BLedDriver() {
 }
 
 void WS2812BLedDriver::SetPower(bool powerOn) {
-  ESP_LOGI(LOG_TAG, "%d", powerOn);
   if (powerOn) {
-    ESP_LOGI(LOG_TAG, "power ON");
+    DLOG(LedDriverPowerOn);
     gpio_set_level(POWER_PIN, 0);
   } else {
-    ESP_LOGI(LOG_TAG, "power OFF");
+    DLOG(LedDriverPowerOff);
     // NOTE: not working a the moment because it needs to be high (5v) and the
     // esp only gives 3.3
     gpio_set_level(POWER_PIN, 1);
@@ -83,7 +83,6 @@ void WS2812BLedDriver::init() {
 }
 
 void WS2812BLedDriver::setColor(RGB_t color) {
-  ESP_LOGI(LOG_TAG, "set Colors");
   std::array<uint8_t, LED_COUNT * 3> led_data = {};
 
   // Populate LED data with the specified color
@@ -99,8 +98,7 @@ void WS2812BLedDriver::setColor(RGB_t color) {
 
   ESP_ERROR_CHECK(rmt_transmit(m_txChannel, m_ledEncoder, led_data.data(),
                                led_data.size(), &tx_config));
-  ESP_LOGI(LOG_TAG, "Set color to R:%d, G:%d, B:%d", color.red, color.green,
-           color.blue);
+  DLOG(LedDriverSetColor, color.red, color.green, color.blue);
 }
 
 void WS2812BLedDriver::deinit() {
@@ -16,11 +16,17 @@
 
 #include "NimBLEDriver.h"
 #include "Application/ApplicationTypes.h"
+#include "Application/Logging/DeferredLogger.h"
 
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/timers.h>
 #include <host/ble_hs.h>
 #include <host/ble_hs_id.h>
 #include <nimble/nimble_port.h>
@@ -32,21 +38,68 @@ namespace {
 constexpr auto LOG_TAG = "NimBLE_DRIVER";
 constexpr char DEVICE_NAME[] = "LedsPhilipp";
 
+// NOTE: minimum time between two state notifications, all state changes in
+// between are batched into a single notification
+constexpr TickType_t STATE_NOTIFY_INTERVAL = pdMS_TO_TICKS(250);
+// NOTE: fits in the default ATT MTU (23) so no MTU exchange is needed
+constexpr size_t STATE_PAYLOAD_SIZE = 20;
+using StatePayload = std::array<uint8_t, STATE_PAYLOAD_SIZE>;
+
 uint8_t blehrAddrType{};
+std::atomic<uint16_t> connHandle{BLE_HS_CONN_HANDLE_NONE};
+std::atomic<bool> stateNotifyEnabled{};
+std::atomic<bool> stateNotifyForced{};
+std::atomic<uint32_t> notifyDrops{};
+TimerHandle_t stateNotifyTimer{};
+StatePayload lastNotifiedState{};
+
+void PutUint16(uint8_t *dst, uint16_t value) {
+  dst[0] = static_cast<uint8_t>(value);
+  dst[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void PutUint32(uint8_t *dst, uint32_t value) {
+  PutUint16(dst, static_cast<uint16_t>(value));
+  PutUint16(dst + 2, static_cast<uint16_t>(value >> 16));
+}
+
+// Layout (little endian):
+//   [0] power, [1..3] R,G,B, [4] brightness, [5] effect,
+//   [6..7] frame rate x10, [8..11] frame count, [12..15] log drops,
+//   [16..19] notify drops
+StatePayload SerializeState(const LedState &state) {
+  StatePayload payload{};
+  payload[0] = state.powerOn ? 1 : 0;
+  payload[1] = state.color.red;
+  payload[2] = state.color.green;
+  payload[3] = state.color.blue;
+  payload[4] = state.brightness;
+  payload[5] = static_cast<uint8_t>(state.effect);
+  PutUint16(&payload[6], state.frameRateX10);
+  PutUint32(&payload[8], state.frameCount);
+  PutUint32(&payload[12], state.logDrops);
+  PutUint32(&payload[16], notifyDrops.load(std::memory_order_relaxed));
+  return payload;
+}
 } // namespace
 
 NimBleDriver::NimBleDriver(
     const NewRGBValueCallback &NewRGBValueCallbackFunc,
-    const NewLedPowerModeCallback &NewLedPowerModeCallbackfunc)
+    const NewLedPowerModeCallback &NewLedPowerModeCallbackfunc,
+    const ReadStateCallback &ReadStateCallbackFunc)
     : m_newRGBValueCallback(NewRGBValueCallbackFunc),
-      m_newLedPowerModeCallback(NewLedPowerModeCallbackfunc) {}
+      m_newLedPowerModeCallback(NewLedPowerModeCallbackfunc),
+      m_readStateCallback(ReadStateCallbackFunc) {}
 
-void NimBleDriver::Init() const {
+void NimBleDriver::Init() {
   ESP_LOGI(LOG_TAG, "Initializing BT Controller and NimBLE stack");
   if (const esp_err_t resultCode = nimble_port_init(); resultCode != ESP_OK) {
     ESP_LOGE(LOG_TAG, "Failed nimble_port_init, error: %d", resultCode);
     return;
   }
+  stateNotifyTimer = xTimerCreate("BleStateNotify", STATE_NOTIFY_INTERVAL,
+                                  pdTRUE, this, NotifyStateTimer);
+  assert(stateNotifyTimer != nullptr && "Failed to create notify timer");
   ble_hs_cfg.sync_cb = OnSync;
   ble_hs_cfg.reset_cb = OnReset;
   GattSvrInit();
@@ -77,11 +130,16 @@ int NimBleDriver::GapEvent(struct ble_gap_event *event,
              event->connect.status);
     if (event->connect.status != 0) {
       Advertise();
+    } else {
+      connHandle = event->connect.conn_handle;
     }
     break;
   }
   case BLE_GAP_EVENT_DISCONNECT: {
     ESP_LOGI(LOG_TAG, "Disconnect; reason=%d", event->disconnect.reason);
+    connHandle = BLE_HS_CONN_HANDLE_NONE;
+    stateNotifyEnabled = false;
+    xTimerStop(stateNotifyTimer, 0);
     Advertise();
     break;
   }
@@ -93,6 +151,15 @@ int NimBleDriver::GapEvent(struct ble_gap_event *event,
   case BLE_GAP_EVENT_SUBSCRIBE: {
     ESP_LOGI(LOG_TAG, "Subscribe event, cur_notify=%d",
              event->subscribe.cur_notify);
+    if (event->subscribe.attr_handle == m_stateValHandle) {
+      stateNotifyEnabled = event->subscribe.cur_notify != 0;
+      if (stateNotifyEnabled) {
+        stateNotifyForced = true;
+        xTimerStart(stateNotifyTimer, 0);
+      } else {
+        xTimerStop(stateNotifyTimer, 0);
+      }
+    }
     break;
   }
   case BLE_GAP_EVENT_MTU: {
@@ -164,12 +231,17 @@ int NimBleDriver::GattAccessRGB([[maybe_unused]] uint16_t conn_handle,
                                 [[maybe_unused]] uint16_t attr_handle,
                                 struct ble_gatt_access_ctxt *ctxt, void *arg) {
   switch (ctxt->op) {
-    //   case BLE_GATT_ACCESS_OP_READ_CHR: {
-    //     // RGB_t currentRGBval{};
-    //     const char *currentRGBvalStr = "40,100,80";
-    //     return os_mbuf_append(ctxt->om, currentRGBvalStr,
-    //     strlen(currentRGBvalStr));
-    //   }
+  case BLE_GATT_ACCESS_OP_READ_CHR: {
+    const auto *nimBLEDriver = static_cast<NimBleDriver *>(arg);
+    const RGB_t currentRGBval = nimBLEDriver->m_readStateCallback().color;
+    std::array<char, 12> currentRGBvalStr{};
+    const int length =
+        snprintf(currentRGBvalStr.data(), currentRGBvalStr.size(), "%d,%d,%d",
+                 currentRGBval.red, currentRGBval.green, currentRGBval.blue);
+    return os_mbuf_append(ctxt->om, currentRGBvalStr.data(), length) == 0
+               ? 0
+               : BLE_ATT_ERR_INSUFFICIENT_RES;
+  }
   case BLE_GATT_ACCESS_OP_WRITE_CHR: {
     std::array<char, 11> newData{};
     uint16_t newDataLength = 0;
@@ -188,7 +260,7 @@ int NimBleDriver::GattAccessRGB([[maybe_unused]] uint16_t conn_handle,
                                             : (blue > 255) ? 255
                                                            : blue);
 
-      ESP_LOGI(LOG_TAG, "NewRGBVal: %s", newData.begin());
+      DLOG(NimBleNewRGBValue, newRGBval.red, newRGBval.green, newRGBval.blue);
       auto *nimBLEDriver = static_cast<NimBleDriver *>(arg);
       nimBLEDriver->m_newRGBValueCallback(newRGBval);
     } else {
@@ -207,12 +279,24 @@ int NimBleDriver::GattAccessLedOnOff([[maybe_unused]] uint16_t conn_handle,
                                      struct ble_gatt_access_ctxt *ctxt,
                                      void *arg) {
   switch (ctxt->op) {
+  case BLE_GATT_ACCESS_OP_READ_CHR: {
+    const auto *nimBLEDriver = static_cast<NimBleDriver *>(arg);
+    const char powerOn =
+        nimBLEDriver->m_readStateCallback().powerOn ? '1' : '0';
+    return os_mbuf_append(ctxt->om, &powerOn, sizeof(powerOn)) == 0
+               ? 0
+               : BLE_ATT_ERR_INSUFFICIENT_RES;
+  }
   case BLE_GATT_ACCESS_OP_WRITE_CHR: {
     std::array<char, 1> newData{};
     uint16_t newDataLength = 0;
     const int resultCode = GattSvrChrWrite(ctxt->om, 0, newData.max_size(),
                                            &newData[0], &newDataLength);
-    ESP_LOGI(LOG_TAG, "Set Leds: %s", newData[0] == '1' ? "ON" : "OFF");
+    if (newData[0] == '1') {
+      DLOG(NimBleSetLedsOn);
+    } else {
+      DLOG(NimBleSetLedsOff);
+    }
     auto *nimBLEDriver = static_cast<NimBleDriver *>(arg);
     nimBLEDriver->m_newLedPowerModeCallback(newData[0] == '1' ? true : false);
     return resultCode;
@@ -223,12 +307,55 @@ int NimBleDriver::GattAccessLedOnOff([[maybe_unused]] uint16_t conn_handle,
   }
 }
 
+int NimBleDriver::GattAccessState([[maybe_unused]] uint16_t conn_handle,
+                                  [[maybe_unused]] uint16_t attr_handle,
+                                  struct ble_gatt_access_ctxt *ctxt,
+                                  void *arg) {
+  switch (ctxt->op) {
+  case BLE_GATT_ACCESS_OP_READ_CHR: {
+    const auto *nimBLEDriver = static_cast<NimBleDriver *>(arg);
+    const StatePayload payload =
+        SerializeState(nimBLEDriver->m_readStateCallback());
+    return os_mbuf_append(ctxt->om, payload.data(), payload.size()) == 0
+               ? 0
+               : BLE_ATT_ERR_INSUFFICIENT_RES;
+  }
+  default:
+    ESP_LOGE(LOG_TAG, "Received unknown GATT operation: %d", ctxt->op);
+    return BLE_ATT_ERR_UNLIKELY;
+  }
+}
+
+void NimBleDriver::NotifyStateTimer(TimerHandle_t timer) {
+  const uint16_t currentConnHandle = connHandle;
+  if (!stateNotifyEnabled || currentConnHandle == BLE_HS_CONN_HANDLE_NONE) {
+    return;
+  }
+  const auto *nimBLEDriver =
+      static_cast<const NimBleDriver *>(pvTimerGetTimerID(timer));
+  const StatePayload payload =
+      SerializeState(nimBLEDriver->m_readStateCallback());
+  const bool forced = stateNotifyForced.exchange(false);
+  if (!forced && payload == lastNotifiedState) {
+    return;
+  }
+
+  os_mbuf *om = ble_hs_mbuf_from_flat(payload.data(), payload.size());
+  // NOTE: ble_gatts_notify_custom takes ownership of om, also on failure
+  if (om == nullptr ||
+      ble_gatts_notify_custom(currentConnHandle, m_stateValHandle, om) != 0) {
+    notifyDrops.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  lastNotifiedState = payload;
+}
+
 int NimBleDriver::GattSvrChrWrite(struct os_mbuf *data, uint16_t min_len,
                                   uint16_t max_len, char *dst, uint16_t *len) {
   if (!len || !dst || data->om_len < min_len || data->om_len > max_len) {
     return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
   }
   const auto resultCode = ble_hs_mbuf_to_flat(data, dst, max_len, len);
-  ESP_LOGI(LOG_TAG, "BLE received %d bytes", *len);
+  DLOG(NimBleReceivedBytes, *len);
   return resultCode;
 }
\ No newline at end of file
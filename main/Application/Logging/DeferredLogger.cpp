@@ -0,0 +1,189 @@
+// ---------------------------------------------------------------------------
+//
+// Filename:
+//   DeferredLogger.cpp
+//
+// Product or product-subsystem:
+//   led project Philipp
+//
+// Original author:
+//   Daphne Annink
+//
+// Description:
+//   Lock-free record buffer and the background task that formats it
+//
+// ---------------------------------------------------------------------------
+
+#include "DeferredLogger.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#if LED_DEFERRED_LOG_ENABLED
+namespace {
+constexpr auto LOG_TAG = "DeferredLog";
+
+constexpr uint32_t RING_CAPACITY = 64; // must be a power of two
+constexpr uint32_t LOG_TASK_STACK_SIZE = 3072;
+constexpr UBaseType_t LOG_TASK_PRIORITY = tskIDLE_PRIORITY + 1;
+constexpr TickType_t LOG_TASK_IDLE_DELAY = pdMS_TO_TICKS(50);
+constexpr size_t MAX_MESSAGE_LENGTH = 96;
+
+static_assert((RING_CAPACITY & (RING_CAPACITY - 1)) == 0,
+              "RING_CAPACITY must be a power of two");
+
+struct LogFormat {
+  const char *tag;
+  const char *format;
+};
+
+#define LED_DEFERRED_LOG_TABLE_ENTRY(id, tag, format) LogFormat{tag, format},
+constexpr std::array LOG_FORMATS = {
+    LED_DEFERRED_LOG_FORMATS(LED_DEFERRED_LOG_TABLE_ENTRY)};
+#undef LED_DEFERRED_LOG_TABLE_ENTRY
+
+constexpr bool AllFormatsValid() {
+  for (const LogFormat &logFormat : LOG_FORMATS) {
+    if (logFormat.tag == nullptr || logFormat.format == nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static_assert(LOG_FORMATS.size() == static_cast<size_t>(LogFormatId::Count),
+              "LOG_FORMATS must have an entry for every LogFormatId");
+static_assert(AllFormatsValid(), "LOG_FORMATS contains a null tag or format");
+
+// Bounded multi-producer/single-consumer queue. Every slot carries a sequence
+// number so producers claim a slot with one CAS and never wait on each other
+// or on the consumer; a full buffer drops the record instead of blocking.
+class LogRingBuffer {
+public:
+  LogRingBuffer() {
+    for (uint32_t i = 0; i < RING_CAPACITY; i++) {
+      m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  bool TryPush(const LogRecord &record) {
+    uint32_t position = m_head.load(std::memory_order_relaxed);
+    Slot *slot = nullptr;
+    for (;;) {
+      slot = &m_slots[position & (RING_CAPACITY - 1)];
+      const uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<int32_t>(sequence - position);
+      if (diff == 0) {
+        if (m_head.compare_exchange_weak(position, position + 1,
+                                         std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else {
+        position = m_head.load(std::memory_order_relaxed);
+      }
+    }
+    slot->record = record;
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // NOTE: only to be called from the log task
+  bool TryPop(LogRecord &record) {
+    Slot &slot = m_slots[m_tail & (RING_CAPACITY - 1)];
+    const uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != m_tail + 1) {
+      return false;
+    }
+    record = slot.record;
+    slot.sequence.store(m_tail + RING_CAPACITY, std::memory_order_release);
+    m_tail++;
+    return true;
+  }
+
+  uint32_t Dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+  struct Slot {
+    std::atomic<uint32_t> sequence{};
+    LogRecord record{};
+  };
+
+  std::array<Slot, RING_CAPACITY> m_slots{};
+  std::atomic<uint32_t> m_head{};
+  std::atomic<uint32_t> m_dropped{};
+  uint32_t m_tail{};
+};
+
+LogRingBuffer ringBuffer{};
+TaskHandle_t logTaskHandle{};
+} // namespace
+#endif
+
+void DeferredLogger::Start() {
+#if LED_DEFERRED_LOG_ENABLED
+  if (logTaskHandle != nullptr) {
+    return;
+  }
+  if (xTaskCreate(LogTask, "DeferredLog", LOG_TASK_STACK_SIZE, nullptr,
+                  LOG_TASK_PRIORITY, &logTaskHandle) != pdPASS) {
+    ESP_LOGE(LOG_TAG, "Failed to create deferred log task");
+  }
+#endif
+}
+
+uint32_t DeferredLogger::DroppedCount() {
+#if LED_DEFERRED_LOG_ENABLED
+  return ringBuffer.Dropped();
+#else
+  return 0;
+#endif
+}
+
+void DeferredLogger::Push([[maybe_unused]] LogRecord &record) {
+#if LED_DEFERRED_LOG_ENABLED
+  record.timestampMs = esp_log_timestamp();
+  ringBuffer.TryPush(record);
+#endif
+}
+
+#if LED_DEFERRED_LOG_ENABLED
+void DeferredLogger::LogTask([[maybe_unused]] void *param) {
+  std::array<char, MAX_MESSAGE_LENGTH> message{};
+  uint32_t reportedDrops = 0;
+  LogRecord record{};
+
+  for (;;) {
+    while (ringBuffer.TryPop(record)) {
+      const auto index = static_cast<size_t>(record.formatId);
+      if (index >= LOG_FORMATS.size()) {
+        continue;
+      }
+      const LogFormat &logFormat = LOG_FORMATS[index];
+      // NOTE: unused trailing arguments are ignored by snprintf
+      snprintf(message.data(), message.size(), logFormat.format,
+               static_cast<int>(record.args[0]),
+               static_cast<int>(record.args[1]),
+               static_cast<int>(record.args[2]));
+      ESP_LOGI(logFormat.tag, "(%lu) %s",
+               static_cast<unsigned long>(record.timestampMs), message.data());
+    }
+
+    const uint32_t drops = ringBuffer.Dropped();
+    if (drops != reportedDrops) {
+      ESP_LOGW(LOG_TAG, "%lu log records dropped (total %lu)",
+               static_cast<unsigned long>(drops - reportedDrops),
+               static_cast<unsigned long>(drops));
+      reportedDrops = drops;
+    }
+    vTaskDelay(LOG_TASK_IDLE_DELAY);
+  }
+}
+#endif
@@ -0,0 +1,81 @@
+// ---------------------------------------------------------------------------
+//
+// Filename:
+//   DeferredLogger.h
+//
+// Product or product-subsystem:
+//   led project Philipp
+//
+// Original author:
+//   Daphne Annink
+//
+// Description:
+//   Deferred logging for hot paths. Callers only push a compact binary record
+//   (format id plus arguments) into a lock-free ring buffer; a low priority
+//   task formats the records and writes them to the UART later.
+//
+//   Configure with -DLED_DEFERRED_LOG=OFF (see main/CMakeLists.txt) to strip
+//   all DLOG calls together with the buffer and the log task.
+//
+// ---------------------------------------------------------------------------
+
+#ifndef BC_APPLICATION_DEFERRED_LOGGER_H
+#define BC_APPLICATION_DEFERRED_LOGGER_H
+
+#include <cstdint>
+
+#ifndef LED_DEFERRED_LOG_ENABLED
+#define LED_DEFERRED_LOG_ENABLED 1
+#endif
+
+// X(id, tag, format): single source for LogFormatId and the format table
+#define LED_DEFERRED_LOG_FORMATS(X)                                           \
+  X(LedDriverPowerOn, "LedDriver", "power ON")                                \
+  X(LedDriverPowerOff, "LedDriver", "power OFF")                              \
+  X(LedDriverSetColor, "LedDriver", "Set color to R:%d, G:%d, B:%d")          \
+  X(LedServicePowerMode, "LedService", "Power mode %d")                       \
+  X(NimBleReceivedBytes, "NimBLE_DRIVER", "BLE received %d bytes")            \
+  X(NimBleNewRGBValue, "NimBLE_DRIVER", "NewRGBVal: %d,%d,%d")                \
+  X(NimBleSetLedsOn, "NimBLE_DRIVER", "Set Leds: ON")                         \
+  X(NimBleSetLedsOff, "NimBLE_DRIVER", "Set Leds: OFF")
+
+#define LED_DEFERRED_LOG_ENUM_ENTRY(id, tag, format) id,
+enum class LogFormatId : uint8_t {
+  LED_DEFERRED_LOG_FORMATS(LED_DEFERRED_LOG_ENUM_ENTRY) Count
+};
+#undef LED_DEFERRED_LOG_ENUM_ENTRY
+
+constexpr uint8_t MAX_LOG_ARGS = 3;
+
+struct LogRecord {
+  uint32_t timestampMs{};
+  LogFormatId formatId{};
+  int32_t args[MAX_LOG_ARGS]{};
+};
+
+class DeferredLogger {
+public:
+  static void Start();
+  static uint32_t DroppedCount();
+
+  template <typename... Args> static void Log(LogFormatId id, Args... args) {
+    static_assert(sizeof...(Args) <= MAX_LOG_ARGS, "Too many log arguments");
+    LogRecord record{};
+    record.formatId = id;
+    [[maybe_unused]] uint8_t index = 0;
+    ((record.args[index++] = static_cast<int32_t>(args)), ...);
+    Push(record);
+  }
+
+private:
+  static void Push(LogRecord &record);
+  static void LogTask(void *param);
+};
+
+#if LED_DEFERRED_LOG_ENABLED
+#define DLOG(id, ...) DeferredLogger::Log(LogFormatId::id, ##__VA_ARGS__)
+#else
+#define DLOG(id, ...) ((void)0)
+#endif
+
+#endif // BC_APPLICATION_DEFERRED_LOGGER_H
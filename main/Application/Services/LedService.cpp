@@ -16,32 +16,90 @@
 
 #include "LedService.h"
 #include "Application/ApplicationTypes.h"
+#include "Application/Logging/DeferredLogger.h"
 
-#include <esp_log.h>
+#include <esp_timer.h>
 
 namespace {
-constexpr auto LOG_TAG = "LedService";
+constexpr int64_t FRAME_RATE_WINDOW_US = 1000 * 1000;
+constexpr uint32_t FRAME_RATE_WINDOW_MS = FRAME_RATE_WINDOW_US / 1000;
+constexpr uint8_t FULL_BRIGHTNESS = 255;
 } // namespace
 
 LedService::LedService()
     : m_nimBLEDriver(std::bind(&LedService::NewRGBValueReceived, this,
                                std::placeholders::_1),
                      std::bind(&LedService::NewLedPowerMode, this,
-                               std::placeholders::_1)) {}
+                               std::placeholders::_1),
+                     std::bind(&LedService::ReadState, this)) {}
 
 void LedService::Start() {
   m_ledDriver.init();
-  m_nimBLEDriver.Init();
+  m_windowStartUs = esp_timer_get_time();
+  m_lastFrameUs = m_windowStartUs;
+
+  // NOTE: render before the BLE host starts, after that all state changes
+  // come from the host task so the snapshot keeps a single writer
+  NewLedPowerMode(true);
+  Render(RGB_t{.red = 255, .green = 5, .blue = 0});
 
-  m_ledDriver.SetPower(true);
-  m_ledDriver.setColor(RGB_t{.red = 255, .green = 5, .blue = 0});
+  m_nimBLEDriver.Init();
 }
 
-void LedService::NewRGBValueReceived(RGB_t newRGBVal) {
-  m_ledDriver.setColor(newRGBVal);
-};
+void LedService::NewRGBValueReceived(RGB_t newRGBVal) { Render(newRGBVal); };
 
 void LedService::NewLedPowerMode(bool powerOn) {
-  ESP_LOGI(LOG_TAG, "%d", powerOn);
+  DLOG(LedServicePowerMode, powerOn);
   m_ledDriver.SetPower(powerOn);
+  m_powerOn = powerOn;
+  PublishState();
 };
+
+LedState LedService::ReadState() const {
+  LedState state = m_stateSnapshot.Read();
+  // NOTE: the rate is only updated by frames, so report 0 once they stop
+  const auto nowMs = static_cast<uint32_t>(esp_timer_get_time() / 1000);
+  if (nowMs - state.lastFrameMs > FRAME_RATE_WINDOW_MS) {
+    state.frameRateX10 = 0;
+  }
+  return state;
+}
+
+void LedService::Render(RGB_t color) {
+  m_ledDriver.setColor(color);
+  m_color = color;
+  m_frameCount++;
+
+  const int64_t nowUs = esp_timer_get_time();
+  if (nowUs - m_lastFrameUs > FRAME_RATE_WINDOW_US) {
+    // NOTE: after an idle gap start a fresh window at this frame
+    m_frameRateX10 = 0;
+    m_windowFrameCount = 0;
+    m_windowStartUs = nowUs;
+  } else {
+    m_windowFrameCount++;
+    const int64_t elapsedUs = nowUs - m_windowStartUs;
+    if (elapsedUs >= FRAME_RATE_WINDOW_US) {
+      m_frameRateX10 = static_cast<uint16_t>(
+          (static_cast<int64_t>(m_windowFrameCount) * 10 * 1000 * 1000) /
+          elapsedUs);
+      m_windowFrameCount = 0;
+      m_windowStartUs = nowUs;
+    }
+  }
+  m_lastFrameUs = nowUs;
+  PublishState();
+}
+
+void LedService::PublishState() {
+  m_stateSnapshot.Publish(LedState{
+      .color = m_color,
+      .powerOn = m_powerOn,
+      .brightness = FULL_BRIGHTNESS, // NOTE: no dimming stage yet
+      .effect = LedEffect::Solid,
+      .frameRateX10 = m_frameRateX10,
+      .frameCount = m_frameCount,
+      .lastFrameMs = static_cast<uint32_t>(m_lastFrameUs / 1000),
+      .logDrops = DeferredLogger::DroppedCount(),
+  });
+}
@@ -20,6 +20,9 @@
 #include "Application/ApplicationTypes.h"
 #include "Application/Drivers/NimBLEDriver.h"
 #include "Application/Drivers/WS2812BLedDriver.h"
+#include "Application/Services/LedStateSnapshot.h"
+
+#include <cstdint>
 
 class LedService {
 public:
@@ -30,9 +33,21 @@ public:
 private:
   void NewRGBValueReceived(RGB_t newRGBVal);
   void NewLedPowerMode(bool powerOn);
+  LedState ReadState() const;
+  void Render(RGB_t color);
+  void PublishState();
 
   NimBleDriver m_nimBLEDriver;
   WS2812BLedDriver m_ledDriver{};
+  LedStateSnapshot m_stateSnapshot{};
+
+  RGB_t m_color{};
+  bool m_powerOn{};
+  uint32_t m_frameCount{};
+  uint32_t m_windowFrameCount{};
+  int64_t m_windowStartUs{};
+  int64_t m_lastFrameUs{};
+  uint16_t m_frameRateX10{};
 };
 
 #endif // BC_APPLICATION_LED_SERVICE_H
\ No newline at end of file
@@ -0,0 +1,55 @@
+// ---------------------------------------------------------------------------
+//
+// Filename:
+//   LedStateSnapshot.cpp
+//
+// Product or product-subsystem:
+//   led project Philipp
+//
+// Original author:
+//   Daphne Annink
+//
+// Description:
+//
+//
+// ---------------------------------------------------------------------------
+
+#include "LedStateSnapshot.h"
+#include "Application/ApplicationTypes.h"
+
+#include <cstring>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable_v<LedState>,
+              "LedState is copied word by word");
+
+void LedStateSnapshot::Publish(const LedState &state) {
+  std::array<uint32_t, WORD_COUNT> words{};
+  std::memcpy(words.data(), &state, sizeof(LedState));
+
+  const uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+  m_sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t i = 0; i < WORD_COUNT; i++) {
+    m_words[i].store(words[i], std::memory_order_relaxed);
+  }
+  m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+LedState LedStateSnapshot::Read() const {
+  std::array<uint32_t, WORD_COUNT> words{};
+  uint32_t before = 0;
+  uint32_t after = 0;
+  do {
+    before = m_sequence.load(std::memory_order_acquire);
+    for (size_t i = 0; i < WORD_COUNT; i++) {
+      words[i] = m_words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    after = m_sequence.load(std::memory_order_relaxed);
+  } while ((before & 1U) != 0 || before != after);
+
+  LedState state{};
+  std::memcpy(static_cast<void *>(&state), words.data(), sizeof(LedState));
+  return state;
+}
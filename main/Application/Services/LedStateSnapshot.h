@@ -0,0 +1,41 @@
+// ---------------------------------------------------------------------------
+//
+// Filename:
+//   LedStateSnapshot.h
+//
+// Product or product-subsystem:
+//   led project Philipp
+//
+// Original author:
+//   Daphne Annink
+//
+// Description:
+//   Lock-free snapshot of the LED state (sequence lock). A single writer
+//   publishes without ever waiting; readers retry when they overlap a publish.
+//
+// ---------------------------------------------------------------------------
+
+#ifndef BC_APPLICATION_LED_STATE_SNAPSHOT_H
+#define BC_APPLICATION_LED_STATE_SNAPSHOT_H
+
+#include "Application/ApplicationTypes.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+class LedStateSnapshot {
+public:
+  // NOTE: only to be called from the render side (single writer)
+  void Publish(const LedState &state);
+  LedState Read() const;
+
+private:
+  static constexpr size_t WORD_COUNT =
+      (sizeof(LedState) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+  std::atomic<uint32_t> m_sequence{};
+  std::array<std::atomic<uint32_t>, WORD_COUNT> m_words{};
+};
+
+#endif // BC_APPLICATION_LED_STATE_SNAPSHOT_H